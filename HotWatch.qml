@@ -11,6 +11,8 @@ Item {
     property bool hasError: false
     property string errorMessage: ""
     property alias defaultHost: client.defaultHost
+    property alias mirror: client.mirror
+    property alias mirrorDir: client.mirrorDir
 
     HotWatchClient {
         id: client
@@ -21,8 +23,17 @@ Item {
             loader.reload()
         }
 
+        onCompileError: function (path, message) {
+            console.warn("Compilation error, keeping current UI:", path)
+            root.hasError = true
+            root.errorMessage = message
+        }
+
         onError: function (message) {
             console.error("Error:", message)
+            // En mode miroir, l'UI locale reste valable sans serveur
+            if (client.mirror && !client.connected && loader.status === Loader.Ready)
+                return
             root.hasError = true
             root.errorMessage = message
         }
@@ -162,6 +173,10 @@ Item {
     }
 
     Component.onCompleted: {
+        // Démarrer tout de suite depuis le miroir local, sans attendre le serveur
+        if (client.mirror && loader.status === Loader.Null) {
+            loader.source = client.getFileUrl()
+        }
         if (active) {
             client.findServer()
         }
@@ -1,9 +1,12 @@
 package main
 
 import (
+	"crypto/sha1"
+	"encoding/hex"
 	"encoding/json"
 	"flag"
 	"fmt"
+	"io"
 	"log"
 	"net"
 	"net/http"
@@ -23,12 +26,20 @@ type Server struct {
 	clients     map[*websocket.Conn]bool
 	clientsLock sync.Mutex
 	upgrader    websocket.Upgrader
+	validator   *Validator
+}
+
+type ManifestEntry struct {
+	Path string `json:"path"`
+	Hash string `json:"hash"`
+	Size int64  `json:"size"`
 }
 
 type FileChangeEvent struct {
-	Type    string `json:"type"`
-	Path    string `json:"path"`
-	Message string `json:"message,omitempty"`
+	Type        string       `json:"type"`
+	Path        string       `json:"path"`
+	Message     string       `json:"message,omitempty"`
+	Diagnostics []Diagnostic `json:"diagnostics,omitempty"`
 }
 
 func NewServer(watchDir string, port int) (*Server, error) {
@@ -83,7 +94,7 @@ func (s *Server) handleFileChanges() {
 				ext := strings.ToLower(filepath.Ext(event.Name))
 				if ext == ".qml" || ext == ".js" || filepath.Base(event.Name) == "qmldir" {
 					log.Printf("File changed: %s", event.Name)
-					s.notifyClients(event.Name)
+					s.validateAndNotify(event.Name)
 				}
 			}
 		case err, ok := <-s.watcher.Errors:
@@ -95,19 +106,66 @@ func (s *Server) handleFileChanges() {
 	}
 }
 
+func (s *Server) validateAndNotify(path string) {
+	if s.validator == nil {
+		s.notifyClients(path)
+		return
+	}
+
+	result, err := s.validator.Validate(path)
+	if err != nil {
+		// Le validateur est une aide : en cas de panne on diffuse quand même
+		log.Printf("Validation error, notifying anyway: %v", err)
+		s.notifyClients(path)
+		return
+	}
+
+	if !result.Ok {
+		for _, d := range result.Diagnostics {
+			log.Printf("Compile error: %s:%d:%d: %s", d.File, d.Line, d.Column, d.Message)
+		}
+		s.notifyDiagnostics(path, result)
+		return
+	}
+
+	log.Printf("Validated %d file(s) for: %s", len(result.Checked), path)
+	s.notifyClients(path)
+}
+
+// relativePath renvoie le chemin vu par le client ("/dir/file.qml"), relatif à watchDir
+func (s *Server) relativePath(path string) string {
+	rel, err := filepath.Rel(s.watchDir, path)
+	if err != nil || strings.HasPrefix(rel, "..") {
+		return path
+	}
+	return "/" + filepath.ToSlash(rel)
+}
+
 func (s *Server) notifyClients(path string) {
-	event := FileChangeEvent{
+	log.Printf("Sending change notification for: %s", path)
+	s.broadcast(FileChangeEvent{
 		Type: "fileChanged",
-		Path: path,
-	}
+		Path: s.relativePath(path),
+	})
+}
+
+func (s *Server) notifyDiagnostics(path string, result *ValidationResult) {
+	log.Printf("Sending diagnostics instead of reload for: %s", path)
+	s.broadcast(FileChangeEvent{
+		Type:        "diagnostics",
+		Path:        s.relativePath(path),
+		Message:     result.Summary(),
+		Diagnostics: result.Diagnostics,
+	})
+}
 
+func (s *Server) broadcast(event FileChangeEvent) {
 	jsonMsg, err := json.Marshal(event)
 	if err != nil {
 		log.Printf("Error marshaling event: %v", err)
 		return
 	}
 
-	log.Printf("Sending change notification for: %s", path)
 	log.Printf("Message content: %s", string(jsonMsg))
 
 	s.clientsLock.Lock()
@@ -199,6 +257,51 @@ func (s *Server) handleFileRequest(w http.ResponseWriter, r *http.Request) {
 	http.ServeFile(w, r, filePath)
 }
 
+// handleManifest liste les fichiers servis avec leur hash, pour le mode miroir des clients
+func (s *Server) handleManifest(w http.ResponseWriter, r *http.Request) {
+	entries := []ManifestEntry{}
+	err := filepath.Walk(s.watchDir, func(path string, info os.FileInfo, err error) error {
+		if err != nil {
+			return err
+		}
+		if strings.HasPrefix(info.Name(), ".") && path != s.watchDir {
+			if info.IsDir() {
+				return filepath.SkipDir
+			}
+			return nil
+		}
+		if info.IsDir() {
+			return nil
+		}
+
+		f, err := os.Open(path)
+		if err != nil {
+			return err
+		}
+		defer f.Close()
+
+		hash := sha1.New()
+		if _, err := io.Copy(hash, f); err != nil {
+			return err
+		}
+
+		entries = append(entries, ManifestEntry{
+			Path: s.relativePath(path),
+			Hash: hex.EncodeToString(hash.Sum(nil)),
+			Size: info.Size(),
+		})
+		return nil
+	})
+	if err != nil {
+		log.Printf("Error building manifest: %v", err)
+		http.Error(w, err.Error(), http.StatusInternalServerError)
+		return
+	}
+
+	w.Header().Set("Content-Type", "application/json")
+	json.NewEncoder(w).Encode(map[string]interface{}{"files": entries})
+}
+
 func (s *Server) handleDiscovery(port int) {
 	addr := net.UDPAddr{
 		Port: 45454,
@@ -246,6 +349,9 @@ func (s *Server) handleDiscovery(port int) {
 func main() {
 	watchDir := flag.String("dir", ".", "Directory to watch")
 	port := flag.Int("port", 8080, "Port to listen on")
+	validatorBin := flag.String("validator", "", "Path to hotwatch-validate (compile QML before notifying clients)")
+	var validatorImports importPathList
+	flag.Var(&validatorImports, "validator-import", "Additional QML import path for the validator (repeatable)")
 	flag.Parse()
 
 	server, err := NewServer(*watchDir, *port)
@@ -253,6 +359,15 @@ func main() {
 		log.Fatal(err)
 	}
 
+	if *validatorBin != "" {
+		validator, err := NewValidator(*validatorBin, *watchDir, validatorImports)
+		if err != nil {
+			log.Fatal(err)
+		}
+		defer validator.Close()
+		server.validator = validator
+	}
+
 	if err := server.watchFiles(); err != nil {
 		log.Fatal(err)
 	}
@@ -261,6 +376,7 @@ func main() {
 	go server.handleDiscovery(*port)
 
 	http.HandleFunc("/ws", server.handleWebSocket)
+	http.HandleFunc("/_hotwatch/manifest", server.handleManifest)
 	http.HandleFunc("/", server.handleFileRequest)
 
 	addr := fmt.Sprintf(":%d", *port)
@@ -0,0 +1,181 @@
+package main
+
+import (
+	"bufio"
+	"encoding/json"
+	"fmt"
+	"io"
+	"log"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"strings"
+	"sync"
+	"time"
+)
+
+// Délai maximal d'une validation : au-delà, le processus est tué et le
+// serveur diffuse le changement sans validation
+const validatorTimeout = 10 * time.Second
+
+type Diagnostic struct {
+	File    string `json:"file"`
+	Line    int    `json:"line"`
+	Column  int    `json:"column"`
+	Message string `json:"message"`
+}
+
+type ValidationResult struct {
+	Path        string       `json:"path"`
+	Ok          bool         `json:"ok"`
+	Checked     []string     `json:"checked"`
+	Diagnostics []Diagnostic `json:"diagnostics"`
+}
+
+// Validator pilote un processus hotwatch-validate de longue durée : un chemin
+// par ligne sur stdin, un résultat JSON par ligne sur stdout. Le moteur QML et
+// le cache par hash restent ainsi chauds entre deux sauvegardes.
+type Validator struct {
+	binary      string
+	watchDir    string
+	importPaths []string
+	cmd         *exec.Cmd
+	stdin       io.WriteCloser
+	stdout      *bufio.Reader
+	lock        sync.Mutex
+}
+
+// importPathList permet de répéter -validator-import sur la ligne de commande
+type importPathList []string
+
+func (l *importPathList) String() string {
+	return strings.Join(*l, ",")
+}
+
+func (l *importPathList) Set(value string) error {
+	*l = append(*l, value)
+	return nil
+}
+
+func NewValidator(binary string, watchDir string, importPaths []string) (*Validator, error) {
+	v := &Validator{
+		binary:      binary,
+		watchDir:    watchDir,
+		importPaths: importPaths,
+	}
+	if err := v.start(); err != nil {
+		return nil, err
+	}
+	return v, nil
+}
+
+func (v *Validator) start() error {
+	args := []string{"--dir", v.watchDir}
+	for _, path := range v.importPaths {
+		args = append(args, "-I", path)
+	}
+	cmd := exec.Command(v.binary, args...)
+	cmd.Stderr = os.Stderr
+
+	stdin, err := cmd.StdinPipe()
+	if err != nil {
+		return fmt.Errorf("failed to open validator stdin: %v", err)
+	}
+	stdout, err := cmd.StdoutPipe()
+	if err != nil {
+		return fmt.Errorf("failed to open validator stdout: %v", err)
+	}
+	if err := cmd.Start(); err != nil {
+		return fmt.Errorf("failed to start validator: %v", err)
+	}
+
+	v.cmd = cmd
+	v.stdin = stdin
+	v.stdout = bufio.NewReader(stdout)
+	log.Printf("Validator started: %s", v.binary)
+	return nil
+}
+
+func (v *Validator) stop() {
+	if v.cmd == nil {
+		return
+	}
+	v.stdin.Close()
+	v.cmd.Process.Kill()
+	v.cmd.Wait()
+	v.cmd = nil
+}
+
+func (v *Validator) Validate(path string) (*ValidationResult, error) {
+	v.lock.Lock()
+	defer v.lock.Unlock()
+
+	absPath, err := filepath.Abs(path)
+	if err != nil {
+		return nil, err
+	}
+
+	// Relancer le processus s'il s'est arrêté depuis la dernière validation
+	if v.cmd == nil {
+		if err := v.start(); err != nil {
+			return nil, err
+		}
+	}
+
+	if _, err := fmt.Fprintln(v.stdin, absPath); err != nil {
+		v.stop()
+		return nil, fmt.Errorf("failed to send path to validator: %v", err)
+	}
+
+	type readResult struct {
+		line []byte
+		err  error
+	}
+	lines := make(chan readResult, 1)
+	stdout := v.stdout
+	go func() {
+		line, err := stdout.ReadBytes('\n')
+		lines <- readResult{line, err}
+	}()
+
+	var line []byte
+	select {
+	case res := <-lines:
+		if res.err != nil {
+			v.stop()
+			return nil, fmt.Errorf("failed to read validator result: %v", res.err)
+		}
+		line = res.line
+	case <-time.After(validatorTimeout):
+		// Le processus tué ferme stdout, ce qui libère la goroutine de lecture
+		v.stop()
+		return nil, fmt.Errorf("validator timed out after %v", validatorTimeout)
+	}
+
+	var result ValidationResult
+	if err := json.Unmarshal(line, &result); err != nil {
+		// Une ligne invalide désynchronise requêtes et réponses : on repart de zéro
+		v.stop()
+		return nil, fmt.Errorf("invalid validator result: %v", err)
+	}
+	return &result, nil
+}
+
+func (v *Validator) Close() {
+	v.lock.Lock()
+	defer v.lock.Unlock()
+	v.stop()
+}
+
+// Summary résume les diagnostics en un message court pour l'overlay du client
+func (r *ValidationResult) Summary() string {
+	if len(r.Diagnostics) == 0 {
+		return ""
+	}
+	d := r.Diagnostics[0]
+	msg := fmt.Sprintf("%s:%d:%d: %s", filepath.Base(d.File), d.Line, d.Column, d.Message)
+	if len(r.Diagnostics) > 1 {
+		msg += fmt.Sprintf(" (+%d more)", len(r.Diagnostics)-1)
+	}
+	return msg
+}
@@ -1,6 +1,10 @@
 #include "HotWatchClient.hpp"
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QUrl>
 #include <QNetworkInterface>
 
@@ -8,7 +12,10 @@
 HotWatchClient *HotWatchClient::instance = nullptr;
 
 HotWatchClient::HotWatchClient(QQmlEngine *engine, QObject *parent)
-    : QObject(parent), m_engine(engine), m_connected(false), m_discoveryAttempts(0), m_defaultHost("")
+    : QObject(parent), m_engine(engine), m_connected(false), m_discoveryAttempts(0), m_defaultHost(""),
+      m_mirror(false), m_mirrorSyncing(false), m_mirrorIndexLoaded(false),
+      m_mirrorFetchSerial(0), m_mirrorSyncQueued(false),
+      m_pendingMirrorFiles(0), m_mirrorUpdatedFiles(0), m_rediscoveryDelay(MIN_REDISCOVERY_DELAY)
 {
     instance = this;
 
@@ -38,12 +45,19 @@ HotWatchClient::HotWatchClient(QQmlEngine *engine, QObject *parent)
     QObject::connect(&m_webSocket, &QWebSocket::errorOccurred,
                      this, &HotWatchClient::handleError);
 
+    m_mirrorDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/hotwatch";
+
     // Configuration du timer de découverte
     m_discoveryTimer.setSingleShot(true);
     m_discoveryTimer.setInterval(1000);
     QObject::connect(&m_discoveryTimer, &QTimer::timeout,
                      this, &HotWatchClient::handleDiscoveryTimeout);
 
+    // En mode miroir, la découverte continue en arrière-plan jusqu'à trouver le serveur
+    m_rediscoveryTimer.setSingleShot(true);
+    QObject::connect(&m_rediscoveryTimer, &QTimer::timeout,
+                     this, &HotWatchClient::handleRediscoveryTimeout);
+
     setupDiscoverySocket();
 }
 
@@ -158,11 +172,46 @@ void HotWatchClient::setSourceFile(const QString &file)
 
 QString HotWatchClient::getFileUrl() const
 {
-    if (m_serverUrl.isEmpty() || m_sourceFile.isEmpty())
+    if (m_sourceFile.isEmpty())
+    {
+        return QString();
+    }
+
+    // En mode miroir, la copie locale est chargée directement, même hors ligne
+    if (m_mirror)
+    {
+        QString localPath = convertToLocalPath(convertToServerPath(m_sourceFile));
+        if (QFile::exists(localPath))
+        {
+            QString result = QUrl::fromLocalFile(localPath).toString();
+            qDebug() << "Generated mirror file URL:" << result;
+            return result;
+        }
+    }
+
+    if (m_serverUrl.isEmpty())
     {
         return QString();
     }
 
+    QUrl fileUrl = serverFileUrl(convertToServerPath(m_sourceFile));
+    if (!fileUrl.isValid())
+    {
+        return QString();
+    }
+
+    // Ajouter un paramètre de cache-busting
+    QUrlQuery query;
+    query.addQueryItem("v", QString::number(QDateTime::currentMSecsSinceEpoch()));
+    fileUrl.setQuery(query);
+
+    QString result = fileUrl.toString();
+    qDebug() << "Generated file URL:" << result;
+    return result;
+}
+
+QUrl HotWatchClient::serverFileUrl(const QString &serverPath) const
+{
     // Nettoyer l'URL du serveur
     QString cleanServerUrl = m_serverUrl;
     if (cleanServerUrl.startsWith(":"))
@@ -175,7 +224,7 @@ QString HotWatchClient::getFileUrl() const
     if (!baseUrl.isValid())
     {
         qDebug() << "Invalid base URL:" << cleanServerUrl;
-        return QString();
+        return QUrl();
     }
 
     // S'assurer que l'URL de base se termine par un slash
@@ -187,23 +236,14 @@ QString HotWatchClient::getFileUrl() const
     baseUrl = QUrl(urlStr);
 
     // Construire le chemin relatif
-    QString path = convertToServerPath(m_sourceFile);
+    QString path = serverPath;
     if (path.startsWith('/'))
     {
         path = path.mid(1); // Enlever le slash initial car l'URL de base en a déjà un
     }
 
     // Résoudre l'URL complète
-    QUrl fileUrl = baseUrl.resolved(QUrl(path));
-
-    // Ajouter un paramètre de cache-busting
-    QUrlQuery query;
-    query.addQueryItem("v", QString::number(QDateTime::currentMSecsSinceEpoch()));
-    fileUrl.setQuery(query);
-
-    QString result = fileUrl.toString();
-    qDebug() << "Generated file URL:" << result;
-    return result;
+    return baseUrl.resolved(QUrl(path));
 }
 
 void HotWatchClient::connect()
@@ -270,6 +310,11 @@ void HotWatchClient::handleConnected()
     // Envoyer un message de test
     QString testMsg = "{\"type\":\"hello\",\"client\":\"qt\"}";
     m_webSocket.sendTextMessage(testMsg);
+
+    if (m_mirror)
+    {
+        syncMirror();
+    }
 }
 
 void HotWatchClient::handleDisconnected()
@@ -322,12 +367,28 @@ void HotWatchClient::handleTextMessage(const QString &message)
         QString localPath = convertToLocalPath(path);
         qDebug() << "Local path:" << localPath;
 
+        // En mode miroir, le signal est émis une fois la copie locale à jour
+        if (m_mirror)
+        {
+            fetchMirrorFile(path, true);
+            return;
+        }
+
         // S'assurer que le cache est bien nettoyé avant d'émettre le signal
         clearCache();
         QCoreApplication::processEvents();
 
         emit fileChanged(localPath);
     }
+    else if (type == "diagnostics")
+    {
+        // Le serveur a refusé le fichier : on garde l'UI actuelle au lieu de recharger
+        QString localPath = convertToLocalPath(obj["path"].toString());
+        QString message = obj["message"].toString();
+        qDebug() << "Compilation failed on server for" << localPath << "-" << message;
+
+        emit compileError(localPath, message);
+    }
     else if (type == "connected")
     {
         qDebug() << "Received connection confirmation from server";
@@ -347,9 +408,31 @@ void HotWatchClient::handleDiscoveryTimeout()
         qDebug() << "Server discovery failed after" << MAX_DISCOVERY_ATTEMPTS << "attempts";
         emit error("Failed to discover server");
         m_discoveryAttempts = 0;
+        scheduleRediscovery();
     }
 }
 
+void HotWatchClient::scheduleRediscovery()
+{
+    if (!m_mirror || m_rediscoveryTimer.isActive())
+    {
+        return;
+    }
+
+    qDebug() << "Retrying server discovery in" << m_rediscoveryDelay << "ms";
+    m_rediscoveryTimer.start(m_rediscoveryDelay);
+    m_rediscoveryDelay = qMin(m_rediscoveryDelay * 2, MAX_REDISCOVERY_DELAY);
+}
+
+void HotWatchClient::handleRediscoveryTimeout()
+{
+    if (!m_mirror || m_connected)
+    {
+        return;
+    }
+    discoverServer();
+}
+
 void HotWatchClient::handleDiscoveryResponse()
 {
     QUdpSocket *socket = qobject_cast<QUdpSocket *>(sender());
@@ -383,6 +466,8 @@ void HotWatchClient::handleDiscoveryResponse()
             qDebug() << "Valid server response, URL:" << url;
 
             m_discoveryTimer.stop();
+            m_rediscoveryTimer.stop();
+            m_rediscoveryDelay = MIN_REDISCOVERY_DELAY;
             m_discoveryAttempts = 0;
             setServerUrl(url);
 
@@ -496,6 +581,7 @@ void HotWatchClient::broadcastDiscovery()
     {
         qDebug() << "Failed to send any discovery broadcasts";
         emit error("Failed to send discovery broadcast");
+        scheduleRediscovery();
     }
 }
 
@@ -540,6 +626,319 @@ void HotWatchClient::setDefaultHost(const QString &host)
     }
 }
 
+void HotWatchClient::setMirror(bool mirror)
+{
+    if (m_mirror != mirror)
+    {
+        m_mirror = mirror;
+        emit mirrorChanged();
+        updateWatchDir();
+        if (m_mirror && m_connected)
+        {
+            syncMirror();
+        }
+    }
+}
+
+void HotWatchClient::setMirrorDir(const QString &dir)
+{
+    QString cleanDir = QDir::cleanPath(dir);
+    if (m_mirrorDir != cleanDir)
+    {
+        m_mirrorDir = cleanDir;
+        emit mirrorDirChanged();
+        updateWatchDir();
+        if (m_mirror && m_connected)
+        {
+            syncMirror();
+        }
+    }
+}
+
+void HotWatchClient::updateWatchDir()
+{
+    // Le miroir reprend l'arborescence du serveur : convertToLocalPath() y mène directement
+    // Le dossier et son index ne sont créés/lus qu'au premier usage : mirror peut être
+    // positionné avant mirrorDir, le dossier par défaut ne doit alors pas être touché
+    QString dir = m_mirror ? m_mirrorDir : QString();
+    if (m_watchDir != dir)
+    {
+        m_watchDir = dir;
+        m_mirrorFiles.clear();
+        m_mirrorIndexLoaded = false;
+        emit watchDirChanged();
+    }
+}
+
+void HotWatchClient::loadMirrorIndex()
+{
+    if (m_mirrorIndexLoaded || m_watchDir.isEmpty())
+    {
+        return;
+    }
+    m_mirrorIndexLoaded = true;
+    m_mirrorFiles.clear();
+
+    QFile file(m_watchDir + "/.hotwatch-mirror.json");
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    const QJsonObject files = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it)
+    {
+        m_mirrorFiles.insert(it.key(), it.value().toString().toLatin1());
+    }
+}
+
+void HotWatchClient::saveMirrorIndex() const
+{
+    if (m_watchDir.isEmpty() || !QDir(m_watchDir).exists())
+    {
+        return;
+    }
+
+    QJsonObject files;
+    for (auto it = m_mirrorFiles.constBegin(); it != m_mirrorFiles.constEnd(); ++it)
+    {
+        files[it.key()] = QString::fromLatin1(it.value());
+    }
+
+    QSaveFile file(m_watchDir + "/.hotwatch-mirror.json");
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qDebug() << "Failed to write mirror index:" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(files).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+void HotWatchClient::syncMirror()
+{
+    if (m_serverUrl.isEmpty())
+    {
+        return;
+    }
+
+    // Une seule synchronisation à la fois : la suivante repart après celle en cours
+    if (m_mirrorSyncing)
+    {
+        m_mirrorSyncQueued = true;
+        return;
+    }
+    m_mirrorSyncing = true;
+
+    QUrl manifestUrl = serverFileUrl("/_hotwatch/manifest");
+    qDebug() << "Fetching mirror manifest:" << manifestUrl.toString();
+
+    QNetworkRequest request(manifestUrl);
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    QNetworkReply *reply = m_network.get(request);
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply]()
+    {
+        reply->deleteLater();
+        if (reply->error() != QNetworkReply::NoError)
+        {
+            qDebug() << "Failed to fetch mirror manifest:" << reply->errorString();
+            m_mirrorSyncing = false;
+            m_mirrorSyncQueued = false;
+            return;
+        }
+
+        QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
+        if (!doc.isObject())
+        {
+            qDebug() << "Invalid mirror manifest received";
+            m_mirrorSyncing = false;
+            m_mirrorSyncQueued = false;
+            return;
+        }
+        handleManifest(doc.object()["files"].toArray());
+    });
+}
+
+void HotWatchClient::handleManifest(const QJsonArray &files)
+{
+    m_pendingMirrorFiles = 0;
+    m_mirrorUpdatedFiles = 0;
+    loadMirrorIndex();
+
+    QSet<QString> remoteFiles;
+    QStringList outdatedFiles;
+    for (const QJsonValue &value : files)
+    {
+        QJsonObject entry = value.toObject();
+        QString path = entry["path"].toString();
+        remoteFiles.insert(path);
+
+        // Comparaison avec l'index plutôt que de relire tout le miroir au démarrage
+        auto owned = m_mirrorFiles.constFind(path);
+        if (owned == m_mirrorFiles.constEnd() || owned.value() != entry["hash"].toString().toLatin1()
+            || !QFile::exists(convertToLocalPath(path)))
+        {
+            outdatedFiles.append(path);
+        }
+    }
+
+    // Supprimer uniquement les fichiers écrits par le miroir et absents du serveur.
+    // Un manifeste vide (serveur lancé sur le mauvais -dir) ne doit pas vider le miroir.
+    if (files.isEmpty())
+    {
+        qDebug() << "Empty mirror manifest, keeping local files";
+    }
+    else
+    {
+        const QStringList ownedFiles = m_mirrorFiles.keys();
+        for (const QString &path : ownedFiles)
+        {
+            if (remoteFiles.contains(path))
+            {
+                continue;
+            }
+            QFile::remove(convertToLocalPath(path));
+            m_mirrorFiles.remove(path);
+            qDebug() << "Removed stale mirror file:" << path;
+            m_mirrorUpdatedFiles++;
+        }
+    }
+
+    qDebug() << "Mirror manifest:" << files.size() << "files," << outdatedFiles.size() << "to update";
+
+    m_pendingMirrorFiles = outdatedFiles.size();
+    for (const QString &path : outdatedFiles)
+    {
+        fetchMirrorFile(path, false);
+    }
+
+    if (m_pendingMirrorFiles == 0)
+    {
+        finishMirrorSync();
+    }
+}
+
+void HotWatchClient::fetchMirrorFile(const QString &serverPath, bool notify)
+{
+    QNetworkRequest request(serverFileUrl(serverPath));
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    QNetworkReply *reply = m_network.get(request);
+
+    // Deux sauvegardes rapprochées lancent deux requêtes qui peuvent finir dans le
+    // désordre : seule la plus récente pour un chemin est écrite dans le miroir
+    const quint64 serial = ++m_mirrorFetchSerial;
+    m_mirrorFetchLatest.insert(serverPath, serial);
+
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, serverPath, notify, serial]()
+    {
+        reply->deleteLater();
+
+        const bool superseded = m_mirrorFetchLatest.value(serverPath) != serial;
+        if (!superseded)
+        {
+            m_mirrorFetchLatest.remove(serverPath);
+        }
+
+        bool written = false;
+        QString failure;
+        if (superseded)
+        {
+            qDebug() << "Dropping superseded mirror fetch for" << serverPath;
+        }
+        else if (reply->error() == QNetworkReply::NoError)
+        {
+            written = writeMirrorFile(serverPath, reply->readAll());
+            if (!written)
+            {
+                failure = "could not write " + convertToLocalPath(serverPath);
+            }
+        }
+        else
+        {
+            failure = reply->errorString();
+            qDebug() << "Failed to fetch mirror file" << serverPath << "-" << failure;
+        }
+
+        // Modification unitaire : recharger dès que le fichier est écrit
+        if (notify)
+        {
+            if (superseded)
+            {
+                return;
+            }
+            if (written)
+            {
+                saveMirrorIndex();
+                clearCache();
+                emit fileChanged(convertToLocalPath(serverPath));
+            }
+            else
+            {
+                // Ne pas perdre la sauvegarde en silence : la copie locale est périmée
+                emit error("Failed to update mirror for " + serverPath + ": " + failure);
+            }
+            return;
+        }
+
+        if (written)
+        {
+            m_mirrorUpdatedFiles++;
+        }
+        if (--m_pendingMirrorFiles == 0)
+        {
+            finishMirrorSync();
+        }
+    });
+}
+
+bool HotWatchClient::writeMirrorFile(const QString &serverPath, const QByteArray &data)
+{
+    QString localPath = QDir::cleanPath(convertToLocalPath(serverPath));
+    if (m_watchDir.isEmpty() || !localPath.startsWith(m_watchDir + "/"))
+    {
+        qDebug() << "Refusing to write outside of mirror:" << serverPath;
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(localPath).absolutePath());
+
+    // Écriture atomique : le moteur ne voit jamais un fichier à moitié écrit
+    QSaveFile file(localPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+    {
+        qDebug() << "Failed to write mirror file" << localPath << "-" << file.errorString();
+        return false;
+    }
+
+    loadMirrorIndex();
+
+    // L'index est enregistré une seule fois, en fin de synchronisation ou après une modification
+    m_mirrorFiles.insert(serverPath, QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+    return true;
+}
+
+void HotWatchClient::finishMirrorSync()
+{
+    qDebug() << "Mirror synchronized," << m_mirrorUpdatedFiles << "files updated";
+    int updatedFiles = m_mirrorUpdatedFiles;
+    m_mirrorUpdatedFiles = 0;
+    saveMirrorIndex();
+
+    if (updatedFiles > 0 && !m_sourceFile.isEmpty())
+    {
+        clearCache();
+        emit fileChanged(convertToLocalPath(convertToServerPath(m_sourceFile)));
+    }
+    m_mirrorSyncing = false;
+    emit mirrorSynced(updatedFiles);
+
+    if (m_mirrorSyncQueued)
+    {
+        m_mirrorSyncQueued = false;
+        syncMirror();
+    }
+}
+
 QString HotWatchClient::convertToServerPath(const QString &localPath) const
 {
     QString path = localPath;
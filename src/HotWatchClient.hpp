@@ -1,10 +1,13 @@
 #ifndef HOTWATCHCLIENT_H
 #define HOTWATCHCLIENT_H
 
+#include "hotwatch_config.h"
 #include <QtCore>
 #include <QtQml>
+#if !HOTWATCH_STUB
 #include <QtNetwork>
 #include <QWebSocket>
+#endif
 
 class HotWatchClient : public QObject
 {
@@ -15,6 +18,8 @@ class HotWatchClient : public QObject
     Q_PROPERTY(QString watchDir READ watchDir NOTIFY watchDirChanged)
     Q_PROPERTY(QString sourceFile READ sourceFile WRITE setSourceFile NOTIFY sourceFileChanged)
     Q_PROPERTY(QString defaultHost READ defaultHost WRITE setDefaultHost NOTIFY defaultHostChanged)
+    Q_PROPERTY(bool mirror READ mirror WRITE setMirror NOTIFY mirrorChanged)
+    Q_PROPERTY(QString mirrorDir READ mirrorDir WRITE setMirrorDir NOTIFY mirrorDirChanged)
 
 public:
     explicit HotWatchClient(QQmlEngine *engine = nullptr, QObject *parent = nullptr);
@@ -31,6 +36,10 @@ public:
     void setSourceFile(const QString &file);
     QString defaultHost() const { return m_defaultHost; }
     void setDefaultHost(const QString &host);
+    bool mirror() const { return m_mirror; }
+    void setMirror(bool mirror);
+    QString mirrorDir() const { return m_mirrorDir; }
+    void setMirrorDir(const QString &dir);
 
     Q_INVOKABLE void connect();
     Q_INVOKABLE void disconnect();
@@ -46,9 +55,14 @@ signals:
     void watchDirChanged();
     void sourceFileChanged();
     void defaultHostChanged();
+    void mirrorChanged();
+    void mirrorDirChanged();
+    void mirrorSynced(int updatedFiles);
     void fileChanged(const QString &path);
+    void compileError(const QString &path, const QString &message);
     void error(const QString &message);
 
+#if !HOTWATCH_STUB
 private slots:
     void handleConnected();
     void handleDisconnected();
@@ -56,8 +70,11 @@ private slots:
     void handleError(QAbstractSocket::SocketError error);
     void handleDiscoveryTimeout();
     void handleDiscoveryResponse();
+    void handleRediscoveryTimeout();
+#endif
 
 private:
+#if !HOTWATCH_STUB
     void discoverServer();
     void updateConnection();
     QString convertToServerPath(const QString &localPath) const;
@@ -65,21 +82,51 @@ private:
     void broadcastDiscovery();
     void setupDiscoverySocket();
     void sendErrorToServer(const QString &errorMsg);
+    QUrl serverFileUrl(const QString &serverPath) const;
+    void syncMirror();
+    void handleManifest(const QJsonArray &files);
+    void fetchMirrorFile(const QString &serverPath, bool notify);
+    bool writeMirrorFile(const QString &serverPath, const QByteArray &data);
+    void finishMirrorSync();
+    void updateWatchDir();
+    void scheduleRediscovery();
+    void loadMirrorIndex();
+    void saveMirrorIndex() const;
+#endif
 
     QQmlEngine *m_engine;
+#if !HOTWATCH_STUB
     QWebSocket m_webSocket;
+#endif
     QString m_serverUrl;
     bool m_connected;
     QString m_watchDir;
     QString m_sourceFile;
     QString m_defaultHost;
+    bool m_mirror;
+    QString m_mirrorDir;
+#if !HOTWATCH_STUB
+    QNetworkAccessManager m_network;
+    bool m_mirrorSyncing;
+    bool m_mirrorSyncQueued;
+    int m_pendingMirrorFiles;
+    int m_mirrorUpdatedFiles;
+    bool m_mirrorIndexLoaded;
+    quint64 m_mirrorFetchSerial;
+    QHash<QString, quint64> m_mirrorFetchLatest; // dernière requête lancée par chemin serveur
+    QHash<QString, QByteArray> m_mirrorFiles; // fichiers écrits par le miroir : chemin serveur -> SHA-1
     QList<QUdpSocket *> m_discoverySocketList;
     QTimer m_discoveryTimer;
+    QTimer m_rediscoveryTimer;
+    int m_rediscoveryDelay;
     int m_discoveryAttempts;
     static const int MAX_DISCOVERY_ATTEMPTS = 3;
     static const int DISCOVERY_TIMEOUT = 1000; // ms
     static const quint16 DISCOVERY_PORT = 45454;
+    static const int MIN_REDISCOVERY_DELAY = 5000;  // ms
+    static const int MAX_REDISCOVERY_DELAY = 60000; // ms
     QtMessageHandler originalMessageHandler;
+#endif
     static HotWatchClient *instance;
 };
 
@@ -0,0 +1,119 @@
+#include "HotWatchClient.hpp"
+
+// Implémentation inerte utilisée quand HOTWATCH_STUB est activé :
+// pas de socket, pas de timer, pas de message handler.
+
+// Initialize static member
+HotWatchClient *HotWatchClient::instance = nullptr;
+
+HotWatchClient::HotWatchClient(QQmlEngine *engine, QObject *parent)
+    : QObject(parent), m_engine(engine), m_connected(false), m_mirror(false)
+{
+    instance = this;
+}
+
+HotWatchClient::~HotWatchClient()
+{
+}
+
+void HotWatchClient::registerQml()
+{
+    qmlRegisterType<HotWatchClient>("HotWatch", 1, 0, "HotWatchClient");
+}
+
+void HotWatchClient::messageHandler(QtMsgType, const QMessageLogContext &, const QString &)
+{
+}
+
+void HotWatchClient::setServerUrl(const QString &url)
+{
+    if (m_serverUrl != url)
+    {
+        m_serverUrl = url;
+        emit serverUrlChanged();
+    }
+}
+
+void HotWatchClient::setSourceFile(const QString &file)
+{
+    if (m_sourceFile != file)
+    {
+        m_sourceFile = file;
+        emit sourceFileChanged();
+    }
+}
+
+void HotWatchClient::setDefaultHost(const QString &host)
+{
+    if (m_defaultHost != host)
+    {
+        m_defaultHost = host;
+        emit defaultHostChanged();
+    }
+}
+
+void HotWatchClient::setMirror(bool mirror)
+{
+    if (m_mirror != mirror)
+    {
+        m_mirror = mirror;
+        emit mirrorChanged();
+    }
+}
+
+void HotWatchClient::setMirrorDir(const QString &dir)
+{
+    if (m_mirrorDir != dir)
+    {
+        m_mirrorDir = dir;
+        emit mirrorDirChanged();
+    }
+}
+
+QString HotWatchClient::getFileUrl() const
+{
+    if (m_sourceFile.isEmpty())
+    {
+        return QString();
+    }
+
+    // URL déjà complète (qrc:, file:, ...) ; une lettre seule est un lecteur Windows
+    QUrl url(m_sourceFile);
+    if (url.scheme().length() > 1)
+    {
+        return m_sourceFile;
+    }
+
+    if (m_sourceFile.startsWith(":/"))
+    {
+        return "qrc" + m_sourceFile;
+    }
+
+    // Chemin du système de fichiers, tel que fourni par l'application
+    return QUrl::fromLocalFile(QFileInfo(m_sourceFile).absoluteFilePath()).toString();
+}
+
+void HotWatchClient::connect()
+{
+}
+
+void HotWatchClient::disconnect()
+{
+}
+
+void HotWatchClient::findServer()
+{
+}
+
+void HotWatchClient::clearCache()
+{
+    if (!m_engine)
+    {
+        m_engine = qmlEngine(this);
+    }
+
+    if (m_engine)
+    {
+        m_engine->clearComponentCache();
+    }
+}
@@ -0,0 +1,239 @@
+#include "HotWatchValidator.hpp"
+#include <QCryptographicHash>
+#include <QDirIterator>
+#include <QJsonArray>
+#include <QRegularExpression>
+
+namespace
+{
+const int MAX_CACHE_ENTRIES = 4096;
+}
+
+QJsonObject HotWatchValidator::Result::toJson() const
+{
+    QJsonArray checked;
+    for (const QString &file : checkedFiles)
+    {
+        checked.append(file);
+    }
+
+    QJsonArray errors;
+    for (const Diagnostic &diagnostic : diagnostics)
+    {
+        QJsonObject entry;
+        entry["file"] = diagnostic.file;
+        entry["line"] = diagnostic.line;
+        entry["column"] = diagnostic.column;
+        entry["message"] = diagnostic.message;
+        errors.append(entry);
+    }
+
+    QJsonObject obj;
+    obj["path"] = path;
+    obj["ok"] = ok;
+    obj["checked"] = checked;
+    obj["diagnostics"] = errors;
+    return obj;
+}
+
+HotWatchValidator::HotWatchValidator(const QString &watchDir, QObject *parent)
+    : QObject(parent), m_watchDir(QFileInfo(watchDir).absoluteFilePath())
+{
+    // Les erreurs sont renvoyées dans le résultat plutôt que sur stderr
+    m_engine.setOutputWarningsToStandardError(false);
+}
+
+void HotWatchValidator::addImportPath(const QString &path)
+{
+    m_engine.addImportPath(path);
+}
+
+void HotWatchValidator::clearCache()
+{
+    m_cache.clear();
+    m_engine.clearComponentCache();
+}
+
+HotWatchValidator::Result HotWatchValidator::validate(const QString &changedPath)
+{
+    Result result;
+    result.path = QFileInfo(changedPath).absoluteFilePath();
+
+    // Un résultat dépend aussi des fichiers importés : la clé couvre tout l'arbre
+    // surveillé, sinon un retour à un contenu déjà vu renverrait un ancien "ok"
+    const QByteArray sourcesHash = treeHash();
+    bool engineCleared = false;
+
+    const QStringList files = filesToCompile(result.path);
+    for (const QString &file : files)
+    {
+        const QByteArray key = file.toUtf8() + '\0' + contentHash(file) + sourcesHash;
+
+        QList<Diagnostic> diagnostics;
+        auto it = m_cache.constFind(key);
+        if (it != m_cache.constEnd())
+        {
+            diagnostics = it.value();
+        }
+        else
+        {
+            // Vider le cache du moteur une seule fois, sinon l'ancien type reste utilisé
+            if (!engineCleared)
+            {
+                m_engine.clearComponentCache();
+                engineCleared = true;
+            }
+
+            diagnostics = compile(file);
+            if (m_cache.size() >= MAX_CACHE_ENTRIES)
+            {
+                m_cache.clear();
+            }
+            m_cache.insert(key, diagnostics);
+        }
+
+        result.checkedFiles.append(file);
+        result.diagnostics.append(diagnostics);
+    }
+
+    result.ok = result.diagnostics.isEmpty();
+    return result;
+}
+
+QStringList HotWatchValidator::filesToCompile(const QString &path) const
+{
+    QFileInfo info(path);
+    if (!info.exists())
+    {
+        return QStringList();
+    }
+
+    const QString suffix = info.suffix().toLower();
+    if (suffix == "qml")
+    {
+        return QStringList{info.absoluteFilePath()} + findDependents(path);
+    }
+    if (suffix == "js")
+    {
+        return findDependents(path);
+    }
+    if (info.fileName() == "qmldir")
+    {
+        // Un qmldir modifié peut casser n'importe quel type du module
+        QStringList files;
+        QDirIterator it(info.absolutePath(), QStringList{"*.qml"}, QDir::Files);
+        while (it.hasNext())
+        {
+            files.append(it.next());
+        }
+        files.sort();
+        return files;
+    }
+    return QStringList();
+}
+
+QStringList HotWatchValidator::findDependents(const QString &path) const
+{
+    QFileInfo info(path);
+    QRegularExpression pattern;
+    if (info.suffix().toLower() == "js")
+    {
+        pattern.setPattern(QString("import\\s+\"([^\"]*/)?%1\"")
+                               .arg(QRegularExpression::escape(info.fileName())));
+    }
+    else
+    {
+        // Utilisation du type, éventuellement qualifié : "Foo {" ou "Module.Foo {"
+        pattern.setPattern(QString("\\b%1\\s*\\{")
+                               .arg(QRegularExpression::escape(info.completeBaseName())));
+    }
+
+    QStringList dependents;
+    QDirIterator it(m_watchDir, QStringList{"*.qml"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        const QString candidate = it.next();
+        if (candidate == info.absoluteFilePath())
+        {
+            continue;
+        }
+
+        QFile file(candidate);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        {
+            continue;
+        }
+        if (pattern.match(QString::fromUtf8(file.readAll())).hasMatch())
+        {
+            dependents.append(candidate);
+        }
+    }
+    dependents.sort();
+    return dependents;
+}
+
+QList<HotWatchValidator::Diagnostic> HotWatchValidator::compile(const QString &file)
+{
+    QQmlComponent component(&m_engine);
+    component.loadUrl(QUrl::fromLocalFile(file), QQmlComponent::PreferSynchronous);
+
+    // Les fichiers locaux sont compilés de façon synchrone, mais on reste prudent
+    while (component.isLoading())
+    {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 50);
+    }
+
+    QList<Diagnostic> diagnostics;
+    const QList<QQmlError> errors = component.errors();
+    for (const QQmlError &error : errors)
+    {
+        // Un module absent (enregistré en C++ par l'application, ou chemin d'import
+        // manquant) n'est pas une erreur du fichier : on ne bloque pas le rechargement
+        if (error.description().contains(QRegularExpression("^module \".*\" is not installed")))
+        {
+            qWarning().noquote() << "Ignoring unresolved import:" << error.toString();
+            continue;
+        }
+
+        Diagnostic diagnostic;
+        diagnostic.file = error.url().isLocalFile() ? error.url().toLocalFile() : error.url().toString();
+        diagnostic.line = error.line();
+        diagnostic.column = error.column();
+        diagnostic.message = error.description();
+        diagnostics.append(diagnostic);
+    }
+    return diagnostics;
+}
+
+QByteArray HotWatchValidator::treeHash() const
+{
+    QStringList files;
+    QDirIterator it(m_watchDir, QStringList{"*.qml", "*.js", "qmldir"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        files.append(it.next());
+    }
+    files.sort();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QString &file : files)
+    {
+        hash.addData(file.toUtf8());
+        hash.addData(QByteArray(1, '\0'));
+        hash.addData(contentHash(file));
+    }
+    return hash.result();
+}
+
+QByteArray HotWatchValidator::contentHash(const QString &file)
+{
+    QFile f(file);
+    if (!f.open(QIODevice::ReadOnly))
+    {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&f);
+    return hash.result();
+}
@@ -0,0 +1,53 @@
+#ifndef HOTWATCHVALIDATOR_H
+#define HOTWATCHVALIDATOR_H
+
+#include <QtCore>
+#include <QtQml>
+
+// Compile les fichiers QML modifiés (et leurs dépendants directs) dans un
+// QQmlEngine sans affichage, avant que le serveur ne notifie les clients.
+class HotWatchValidator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Diagnostic
+    {
+        QString file;
+        int line = -1;
+        int column = -1;
+        QString message;
+    };
+
+    struct Result
+    {
+        QString path;
+        bool ok = true;
+        QStringList checkedFiles;
+        QList<Diagnostic> diagnostics;
+
+        QJsonObject toJson() const;
+    };
+
+    explicit HotWatchValidator(const QString &watchDir, QObject *parent = nullptr);
+
+    void addImportPath(const QString &path);
+    QString watchDir() const { return m_watchDir; }
+
+    Result validate(const QString &changedPath);
+    void clearCache();
+
+private:
+    QStringList findDependents(const QString &path) const;
+    QStringList filesToCompile(const QString &path) const;
+    QList<Diagnostic> compile(const QString &file);
+    QByteArray treeHash() const;
+    static QByteArray contentHash(const QString &file);
+
+    QQmlEngine m_engine;
+    QString m_watchDir;
+    // Clé : chemin + hash du fichier compilé + hash de tous les sources du dossier surveillé
+    QHash<QByteArray, QList<Diagnostic>> m_cache;
+};
+
+#endif // HOTWATCHVALIDATOR_H
@@ -0,0 +1,47 @@
+import QtQuick
+import HotWatch
+
+// Version inerte de HotWatch.qml, utilisée quand HOTWATCH_STUB est activé :
+// mêmes propriétés, mais le Loader charge sourceFile directement.
+Item {
+    id: root
+
+    property bool active: false
+    property string sourceFile
+    property alias loaderItem: loader
+    property bool hasError: false
+    property string errorMessage: ""
+    property alias defaultHost: client.defaultHost
+    property alias mirror: client.mirror
+    property alias mirrorDir: client.mirrorDir
+
+    HotWatchClient {
+        id: client
+        sourceFile: root.sourceFile
+    }
+
+    Loader {
+        id: loader
+        anchors.fill: parent
+        asynchronous: true
+        source: client.sourceFile !== "" ? client.getFileUrl() : ""
+
+        onStatusChanged: {
+            if (status === Loader.Error) {
+                console.error("Failed to load:", source)
+                root.hasError = true
+                root.errorMessage = "Failed to load: " + source
+            } else if (status === Loader.Ready) {
+                root.hasError = false
+                root.errorMessage = ""
+            }
+        }
+    }
+
+    function reload() {
+        var url = loader.source
+        loader.source = ""
+        client.clearCache()
+        loader.source = url
+    }
+}
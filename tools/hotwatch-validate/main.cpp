@@ -0,0 +1,73 @@
+#include "HotWatchValidator.hpp"
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QJsonDocument>
+#include <cstdio>
+
+// Outil côté serveur : compile les fichiers modifiés avant leur diffusion.
+//
+//   hotwatch-validate --dir <watchDir> [-I <importPath>] [fichiers...]
+//
+// Sans fichier en argument, lit un chemin par ligne sur stdin et écrit un
+// résultat JSON par ligne sur stdout (mode utilisé par goserver).
+static void writeResult(const HotWatchValidator::Result &result)
+{
+    QByteArray line = QJsonDocument(result.toJson()).toJson(QJsonDocument::Compact);
+    line.append('\n');
+    fwrite(line.constData(), 1, line.size(), stdout);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    // Pas d'écran côté serveur
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("hotwatch-validate");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compile changed QML files headlessly before hot reload");
+    parser.addHelpOption();
+    QCommandLineOption dirOption("dir", "Watched directory", "dir", ".");
+    QCommandLineOption importOption("I", "Additional QML import path", "path");
+    parser.addOption(dirOption);
+    parser.addOption(importOption);
+    parser.addPositionalArgument("files", "Files to validate (reads stdin when empty)", "[files...]");
+    parser.process(app);
+
+    HotWatchValidator validator(parser.value(dirOption));
+    for (const QString &path : parser.values(importOption))
+    {
+        validator.addImportPath(path);
+    }
+
+    const QStringList files = parser.positionalArguments();
+    if (!files.isEmpty())
+    {
+        bool ok = true;
+        for (const QString &file : files)
+        {
+            HotWatchValidator::Result result = validator.validate(file);
+            writeResult(result);
+            ok = ok && result.ok;
+        }
+        return ok ? 0 : 1;
+    }
+
+    QTextStream in(stdin);
+    QString line;
+    while (in.readLineInto(&line))
+    {
+        line = line.trimmed();
+        if (line.isEmpty())
+        {
+            continue;
+        }
+        writeResult(validator.validate(line));
+    }
+    return 0;
+}